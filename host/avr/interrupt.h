@@ -0,0 +1,15 @@
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+// Host stand-in for <avr/interrupt.h>. Interrupt vectors become plain
+// functions that sim.c calls when the emulated peripheral raises them.
+
+#define ISR(vector) void vector(void)
+
+void sim_sei(void);
+void sim_cli(void);
+
+#define sei() sim_sei()
+#define cli() sim_cli()
+
+#endif // HOST_AVR_INTERRUPT_H
@@ -0,0 +1,139 @@
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+// Host stand-in for <avr/io.h>. Only the ATtiny1626 registers and bit masks the
+// firmware uses are provided, backed by plain memory in io.c. Every register
+// access first calls io_access(), which lets the simulator in sim.c advance
+// time, update the peripherals and run due interrupts between accesses.
+
+typedef volatile uint8_t register8_t;
+typedef volatile uint16_t register16_t;
+
+typedef struct
+{
+    register8_t DIR, DIRSET, DIRCLR, DIRTGL;
+    register8_t OUT, OUTSET, OUTCLR, OUTTGL;
+    register8_t IN, INTFLAGS, PORTCTRL;
+    register8_t PIN0CTRL, PIN1CTRL, PIN2CTRL, PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+} PORT_t;
+
+typedef struct
+{
+    register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLECLR, CTRLESET, CTRLFCLR, CTRLFSET;
+    register8_t EVCTRL, INTCTRL, INTFLAGS, DBGCTRL, TEMP;
+    register16_t CNT, PER, CMP0, CMP1, CMP2, PERBUF, CMP0BUF, CMP1BUF, CMP2BUF;
+} TCA_SINGLE_t;
+
+typedef union
+{
+    TCA_SINGLE_t SINGLE;
+} TCA_t;
+
+typedef struct
+{
+    register8_t CTRLA, CTRLB, EVCTRL, INTCTRL, INTFLAGS, STATUS, DBGCTRL, TEMP;
+    register16_t CNT, CCMP;
+} TCB_t;
+
+typedef struct
+{
+    register8_t CTRLA, CTRLB, INTCTRL, INTFLAGS;
+    register16_t DATA; // Holds SPI_DATA_EMPTY until the firmware writes a byte
+} SPI_t;
+
+typedef struct
+{
+    register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLE, CTRLF, COMMAND, PGACTRL;
+    register8_t MUXPOS, MUXNEG, INTCTRL, INTFLAGS, STATUS;
+    register16_t RESULT;
+} ADC_t;
+
+typedef struct
+{
+    register8_t RXDATAL, RXDATAH, TXDATAL, TXDATAH, STATUS;
+    register8_t CTRLA, CTRLB, CTRLC;
+    register16_t BAUD;
+} USART_t;
+
+typedef struct
+{
+    register8_t EVSYSROUTEA, CCLROUTEA, USARTROUTEA, SPIROUTEA, TCAROUTEA, TCBROUTEA;
+} PORTMUX_t;
+
+#define SPI_DATA_EMPTY 0x100
+
+// Register storage, see io.c
+extern PORT_t io_PORTA, io_PORTB, io_PORTC;
+extern TCA_t io_TCA0;
+extern TCB_t io_TCB0, io_TCB1;
+extern SPI_t io_SPI0;
+extern ADC_t io_ADC0;
+extern USART_t io_USART0;
+extern PORTMUX_t io_PORTMUX;
+extern register8_t io_GPIOR0, io_GPIOR1, io_GPIOR2, io_GPIOR3;
+
+// Called before every register access; runs io_access_hook if one is set
+extern void (*io_access_hook)(void);
+void io_access(void);
+
+#define IO_REG(reg) (*(io_access(), &(reg)))
+
+#define PORTA IO_REG(io_PORTA)
+#define PORTB IO_REG(io_PORTB)
+#define PORTC IO_REG(io_PORTC)
+#define TCA0 IO_REG(io_TCA0)
+#define TCB0 IO_REG(io_TCB0)
+#define TCB1 IO_REG(io_TCB1)
+#define SPI0 IO_REG(io_SPI0)
+#define ADC0 IO_REG(io_ADC0)
+#define USART0 IO_REG(io_USART0)
+#define PORTMUX IO_REG(io_PORTMUX)
+
+// General purpose I/O registers
+#define GPIOR0 IO_REG(io_GPIOR0)
+#define GPIOR1 IO_REG(io_GPIOR1)
+#define GPIOR2 IO_REG(io_GPIOR2)
+#define GPIOR3 IO_REG(io_GPIOR3)
+
+#define PIN0_bm 0x01
+#define PIN1_bm 0x02
+#define PIN2_bm 0x04
+#define PIN3_bm 0x08
+#define PIN4_bm 0x10
+#define PIN5_bm 0x20
+#define PIN6_bm 0x40
+#define PIN7_bm 0x80
+
+#define PORT_PULLUPEN_bm 0x08
+#define PORTMUX_SPI0_ALT1_gc 0x01
+
+#define TCA_SINGLE_ENABLE_bm 0x01
+#define TCA_SINGLE_CMP0EN_bm 0x10
+#define TCA_SINGLE_WGMODE_SINGLESLOPE_gc 0x03
+
+#define TCB_ENABLE_bm 0x01
+#define TCB_CAPT_bm 0x01
+
+#define SPI_ENABLE_bm 0x01
+#define SPI_MASTER_bm 0x20
+#define SPI_SSD_bm 0x04
+#define SPI_IE_bm 0x01
+#define SPI_IF_bm 0x80
+
+#define ADC_ENABLE_bm 0x01
+#define ADC_PRESC_DIV2_gc 0x00
+#define ADC_TIMEBASE_gp 3
+#define ADC_REFSEL_VDD_gc 0x00
+#define ADC_FREERUN_bm 0x02
+#define ADC_LEFTADJ_bm 0x01
+#define ADC_MUXPOS_AIN2_gc 0x02
+#define ADC_MODE_SINGLE_8BIT_gc 0x00
+#define ADC_START_IMMEDIATE_gc 0x01
+
+#define USART_RXCIE_bm 0x80
+#define USART_RXEN_bm 0x80
+#define USART_TXEN_bm 0x40
+
+#endif // HOST_AVR_IO_H
@@ -0,0 +1,57 @@
+#!/bin/sh
+# Builds the firmware at two revisions with avr-gcc for the ATtiny1626 and
+# reports what the GPIOR0 flags change did to the generated code:
+#   - flash and RAM use (avr-size)
+#   - size and instruction count of TCB0_INT_vect and TCB1_INT_vect
+#   - instruction count of main(), which holds the inlined state machine and
+#     its polling loops
+#   - every SBI/CBI/SBIS/SBIC on GPIOR0 (I/O address 0x1c)
+# The disassembly of both builds is left in the work directory for cycle
+# counting of individual loops.
+#
+# Usage, from the repository root:
+#   host/avr_measure.sh [before] [after]
+# before defaults to the revision just ahead of the one that added flags.h,
+# after defaults to HEAD. Needs avr-gcc, avr-libc with ATtiny1626 support and
+# binutils-avr on the PATH.
+
+set -e
+
+after=${2:-HEAD}
+before=${1:-$(git log --diff-filter=A --format=%H -- include/flags.h | tail -n 1)^}
+work=${TMPDIR:-/tmp}/avr_measure
+cflags="-mmcu=attiny1626 -Os -std=gnu99 -fcommon -DF_CPU=3333333UL -Iinclude"
+
+rm -rf "$work"
+mkdir -p "$work"
+
+# Interrupt vector symbols, e.g. __vector_13
+vectors=$(printf '#include <avr/io.h>\nTCB0_INT_vect TCB1_INT_vect\n' | avr-gcc -mmcu=attiny1626 -E -P - | tail -n 1)
+tcb0=$(echo "$vectors" | awk '{print $1}')
+tcb1=$(echo "$vectors" | awk '{print $2}')
+
+# Prints the instruction count of one function in a disassembly listing
+count_instructions()
+{
+    awk -v name="<$2>:" '$2 == name { inside = 1; next } inside && /^$/ { exit } inside && /^ +[0-9a-f]+:/ { n++ } END { print n + 0 }' "$1"
+}
+
+for label in before after; do
+    eval rev=\$$label
+    mkdir -p "$work/$label"
+    git archive "$rev" src include | tar -x -C "$work/$label"
+    (cd "$work/$label" && avr-gcc $cflags src/*.c -o firmware.elf)
+    elf=$work/$label/firmware.elf
+    avr-objdump -d "$elf" > "$work/$label/firmware.lst"
+
+    echo "== $label ($(git rev-parse --short "$rev"))"
+    avr-size "$elf"
+    avr-nm -S --radix=d "$elf" | awk -v a="$tcb0" -v b="$tcb1" '$4 == a { print "TCB0_INT_vect bytes: " $2 + 0 } $4 == b { print "TCB1_INT_vect bytes: " $2 + 0 }'
+    echo "TCB0_INT_vect instructions: $(count_instructions "$work/$label/firmware.lst" "$tcb0")"
+    echo "TCB1_INT_vect instructions: $(count_instructions "$work/$label/firmware.lst" "$tcb1")"
+    echo "main instructions: $(count_instructions "$work/$label/firmware.lst" main)"
+    echo "GPIOR0 bit instructions:"
+    grep -E '[[:space:]](sbi|cbi|sbis|sbic)[[:space:]]+0x1[cC],' "$work/$label/firmware.lst" || echo "  (none)"
+done
+
+echo "Disassembly: $work/before/firmware.lst $work/after/firmware.lst"
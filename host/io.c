@@ -0,0 +1,19 @@
+#include <avr/io.h>
+
+// Register storage for the host build of the firmware sources
+PORT_t io_PORTA, io_PORTB, io_PORTC;
+TCA_t io_TCA0;
+TCB_t io_TCB0, io_TCB1;
+SPI_t io_SPI0 = {.DATA = SPI_DATA_EMPTY};
+ADC_t io_ADC0;
+USART_t io_USART0;
+PORTMUX_t io_PORTMUX;
+register8_t io_GPIOR0, io_GPIOR1, io_GPIOR2, io_GPIOR3;
+
+void (*io_access_hook)(void);
+
+void io_access(void)
+{
+    if (io_access_hook)
+        io_access_hook();
+}
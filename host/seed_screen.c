@@ -0,0 +1,416 @@
+// Host-side seed screening for the sequence LFSR.
+//
+// Steps many Galois LFSRs at once (8 lanes with AVX2, 4 with SSE4.1, else
+// scalar) and keeps running statistics for each seed: how often each of the
+// four pad digits comes up and the longest run of one pad. Seeds with a long
+// run or a skewed digit distribution are rejected; accepted seeds are printed
+// one per line in hex, in seed order.
+//
+// Build from the repository root:
+//   gcc -O3 -march=native -pthread -Iinclude -Ihost host/seed_screen.c host/io.c src/sequence.c -o seed_screen
+//
+// Usage:
+//   seed_screen [-s first] [-n count] [-l length] [-r max_run] [-x max_chi2] [-t threads] [-v] [-b]
+//     -v  check the vector statistics against next() from sequence.c
+//     -b  benchmark the sequence.c scalar loop against the vector generator
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sequence.h"
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#define BLOCK_SEEDS 4096 // Seeds handed to a worker at a time
+#define SEED_TEXT 11     // Characters in one line of output, "0x%08X\n"
+
+// Statistics for one seed over the first `length` digits
+typedef struct
+{
+    uint32_t counts[4]; // Occurrences of each pad digit
+    uint32_t max_run;   // Longest run of one digit
+} Seed_Stats;
+
+// Screening options shared by all workers
+typedef struct
+{
+    uint64_t first;   // First seed to screen
+    uint64_t end;     // One past the last seed
+    uint32_t length;  // Digits generated per seed
+    uint32_t max_run; // Longest run allowed
+    double max_chi2;  // Largest chi-square allowed over the four digits
+} Screen_Options;
+
+static Screen_Options options = {0, 1ULL << 20, 64, 5, 11.345}; // 11.345 is p = 0.01 at 3 degrees of freedom
+
+static uint64_t next_block;         // Next seed offset to hand out
+static uint64_t accepted, too_long, too_skewed;
+static FILE *output;                // Where accepted seeds are written, NULL to only count them
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t block_turn = PTHREAD_COND_INITIALIZER; // Signalled each time a block is written
+static uint64_t blocks_written;     // Blocks written so far, the next one allowed to write
+
+// Reference statistics using next() from sequence.c, one seed at a time
+static void stats_sequence_c(uint32_t seed, uint32_t length, Seed_Stats *stats)
+{
+    uint8_t prev = 0xFF;
+    uint32_t run = 0;
+
+    memset(stats, 0, sizeof(*stats));
+    state_lfsr = seed;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        next();
+        stats->counts[next_lfsr_digit]++;
+        run = (next_lfsr_digit == prev) ? run + 1 : 1;
+        if (run > stats->max_run)
+            stats->max_run = run;
+        prev = next_lfsr_digit;
+    }
+}
+
+// Plain C generator for a block of consecutive seeds, used when no vector unit is enabled
+static void stats_block_scalar(uint32_t first, uint32_t count, uint32_t length, Seed_Stats *stats)
+{
+    for (uint32_t lane = 0; lane < count; lane++)
+    {
+        uint32_t state = first + lane;
+        uint32_t prev = 4, run = 0;
+        Seed_Stats *s = &stats[lane];
+
+        memset(s, 0, sizeof(*s));
+        for (uint32_t i = 0; i < length; i++)
+        {
+            state = (state >> 1) ^ (-(state & 1) & LFSR_MASK);
+            uint32_t digit = state & 0b11;
+            s->counts[digit]++;
+            run = (digit == prev) ? run + 1 : 1;
+            if (run > s->max_run)
+                s->max_run = run;
+            prev = digit;
+        }
+    }
+}
+
+#if defined(__AVX2__)
+#define LANES 8
+
+// Eight consecutive seeds per pass, one per 32-bit lane
+static void stats_lanes(uint32_t first, uint32_t length, Seed_Stats *stats)
+{
+    const __m256i taps = _mm256_set1_epi32((int)LFSR_MASK);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i digit_bits = _mm256_set1_epi32(0b11);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i state = _mm256_add_epi32(_mm256_set1_epi32((int)first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i prev = _mm256_set1_epi32(4); // Matches no digit
+    __m256i count0 = zero, count1 = zero, count2 = zero, run = zero, max_run = zero;
+    uint32_t c0[LANES], c1[LANES], c2[LANES], mr[LANES];
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        __m256i feedback = _mm256_sub_epi32(zero, _mm256_and_si256(state, one)); // All ones where the LSB was set
+        state = _mm256_xor_si256(_mm256_srli_epi32(state, 1), _mm256_and_si256(feedback, taps));
+        __m256i digit = _mm256_and_si256(state, digit_bits);
+
+        count0 = _mm256_sub_epi32(count0, _mm256_cmpeq_epi32(digit, zero)); // Compare results are -1 where true
+        count1 = _mm256_sub_epi32(count1, _mm256_cmpeq_epi32(digit, one));
+        count2 = _mm256_sub_epi32(count2, _mm256_cmpeq_epi32(digit, two));
+
+        run = _mm256_add_epi32(_mm256_and_si256(run, _mm256_cmpeq_epi32(digit, prev)), one); // Extend or restart the run
+        max_run = _mm256_max_epu32(max_run, run);
+        prev = digit;
+    }
+
+    _mm256_storeu_si256((__m256i *)c0, count0);
+    _mm256_storeu_si256((__m256i *)c1, count1);
+    _mm256_storeu_si256((__m256i *)c2, count2);
+    _mm256_storeu_si256((__m256i *)mr, max_run);
+    for (int lane = 0; lane < LANES; lane++)
+    {
+        stats[lane].counts[0] = c0[lane];
+        stats[lane].counts[1] = c1[lane];
+        stats[lane].counts[2] = c2[lane];
+        stats[lane].counts[3] = length - c0[lane] - c1[lane] - c2[lane];
+        stats[lane].max_run = mr[lane];
+    }
+}
+#elif defined(__SSE4_1__)
+#define LANES 4
+
+// Four consecutive seeds per pass, one per 32-bit lane
+static void stats_lanes(uint32_t first, uint32_t length, Seed_Stats *stats)
+{
+    const __m128i taps = _mm_set1_epi32((int)LFSR_MASK);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i digit_bits = _mm_set1_epi32(0b11);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i state = _mm_add_epi32(_mm_set1_epi32((int)first), _mm_setr_epi32(0, 1, 2, 3));
+    __m128i prev = _mm_set1_epi32(4); // Matches no digit
+    __m128i count0 = zero, count1 = zero, count2 = zero, run = zero, max_run = zero;
+    uint32_t c0[LANES], c1[LANES], c2[LANES], mr[LANES];
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        __m128i feedback = _mm_sub_epi32(zero, _mm_and_si128(state, one)); // All ones where the LSB was set
+        state = _mm_xor_si128(_mm_srli_epi32(state, 1), _mm_and_si128(feedback, taps));
+        __m128i digit = _mm_and_si128(state, digit_bits);
+
+        count0 = _mm_sub_epi32(count0, _mm_cmpeq_epi32(digit, zero)); // Compare results are -1 where true
+        count1 = _mm_sub_epi32(count1, _mm_cmpeq_epi32(digit, one));
+        count2 = _mm_sub_epi32(count2, _mm_cmpeq_epi32(digit, two));
+
+        run = _mm_add_epi32(_mm_and_si128(run, _mm_cmpeq_epi32(digit, prev)), one); // Extend or restart the run
+        max_run = _mm_max_epu32(max_run, run);
+        prev = digit;
+    }
+
+    _mm_storeu_si128((__m128i *)c0, count0);
+    _mm_storeu_si128((__m128i *)c1, count1);
+    _mm_storeu_si128((__m128i *)c2, count2);
+    _mm_storeu_si128((__m128i *)mr, max_run);
+    for (int lane = 0; lane < LANES; lane++)
+    {
+        stats[lane].counts[0] = c0[lane];
+        stats[lane].counts[1] = c1[lane];
+        stats[lane].counts[2] = c2[lane];
+        stats[lane].counts[3] = length - c0[lane] - c1[lane] - c2[lane];
+        stats[lane].max_run = mr[lane];
+    }
+}
+#endif
+
+// Statistics for a block of consecutive seeds, vectorised where possible
+static void stats_block(uint32_t first, uint32_t count, uint32_t length, Seed_Stats *stats)
+{
+    uint32_t done = 0;
+#ifdef LANES
+    for (; done + LANES <= count; done += LANES)
+        stats_lanes(first + done, length, &stats[done]);
+#endif
+    stats_block_scalar(first + done, count - done, length, &stats[done]);
+}
+
+// Pearson's chi-square of the digit counts against a uniform distribution
+static double chi_square(const Seed_Stats *stats, uint32_t length)
+{
+    double chi2 = 0;
+    for (int digit = 0; digit < 4; digit++)
+    {
+        double diff = 4.0 * stats->counts[digit] - length;
+        chi2 += diff * diff;
+    }
+    return chi2 / (4.0 * length);
+}
+
+// Formats a seed as one output line, "0x%08X\n" without the cost of printf
+static void format_seed(char *text, uint32_t seed)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    text[0] = '0';
+    text[1] = 'x';
+    for (int digit = 9; digit >= 2; digit--, seed >>= 4)
+        text[digit] = hex[seed & 0xF];
+    text[10] = '\n';
+}
+
+// Worker thread: takes blocks of seeds until the range is used up. Accepted
+// seeds are formatted outside the lock, then each block waits its turn so the
+// output is in seed order whatever the thread count.
+static void *screen_worker(void *arg)
+{
+    static __thread Seed_Stats stats[BLOCK_SEEDS];
+    static __thread char text[BLOCK_SEEDS * SEED_TEXT];
+    (void)arg;
+
+    while (1)
+    {
+        uint64_t offset = __atomic_fetch_add(&next_block, BLOCK_SEEDS, __ATOMIC_RELAXED);
+        uint64_t first = options.first + offset;
+        if (first >= options.end)
+            break;
+        uint32_t count = (options.end - first < BLOCK_SEEDS) ? (uint32_t)(options.end - first) : BLOCK_SEEDS;
+        uint32_t kept = 0, long_runs = 0, skewed = 0;
+
+        stats_block((uint32_t)first, count, options.length, stats);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (stats[i].max_run > options.max_run)
+                long_runs++;
+            else if (chi_square(&stats[i], options.length) > options.max_chi2)
+                skewed++;
+            else if (output)
+                format_seed(&text[SEED_TEXT * kept++], (uint32_t)first + i);
+            else
+                kept++;
+        }
+
+        pthread_mutex_lock(&output_lock);
+        while (blocks_written != offset / BLOCK_SEEDS)
+            pthread_cond_wait(&block_turn, &output_lock);
+        if (output)
+            fwrite(text, SEED_TEXT, kept, output);
+        accepted += kept;
+        too_long += long_runs;
+        too_skewed += skewed;
+        blocks_written++;
+        pthread_cond_broadcast(&block_turn);
+        pthread_mutex_unlock(&output_lock);
+    }
+    return NULL;
+}
+
+// Screens the configured range on the given number of threads
+static void screen(int threads)
+{
+    pthread_t workers[threads];
+
+    next_block = 0;
+    blocks_written = 0;
+    for (int i = 0; i < threads; i++)
+        pthread_create(&workers[i], NULL, screen_worker, NULL);
+    for (int i = 0; i < threads; i++)
+        pthread_join(workers[i], NULL);
+}
+
+// Compares the block generator with next() from sequence.c, returns the number of mismatching seeds
+static uint64_t verify(void)
+{
+    static Seed_Stats fast[BLOCK_SEEDS];
+    Seed_Stats reference;
+    uint64_t mismatches = 0;
+
+    for (uint64_t first = options.first; first < options.end; first += BLOCK_SEEDS)
+    {
+        uint32_t count = (options.end - first < BLOCK_SEEDS) ? (uint32_t)(options.end - first) : BLOCK_SEEDS;
+        stats_block((uint32_t)first, count, options.length, fast);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            stats_sequence_c((uint32_t)first + i, options.length, &reference);
+            if (memcmp(&reference, &fast[i], sizeof(reference)) != 0)
+            {
+                if (mismatches++ < 10)
+                    fprintf(stderr, "mismatch at seed 0x%08" PRIX32 "\n", (uint32_t)first + i);
+            }
+        }
+    }
+    return mismatches;
+}
+
+static double seconds_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Times the same screening (statistics and accept/reject, no output) through
+// the sequence.c loop, then the block generator on one thread and on all threads
+static void benchmark(int threads)
+{
+    Seed_Stats reference;
+    uint64_t seeds = options.end - options.first;
+    volatile uint32_t sink = 0;
+    double start, elapsed;
+
+    start = seconds_now();
+    for (uint64_t seed = options.first; seed < options.end; seed++)
+    {
+        stats_sequence_c((uint32_t)seed, options.length, &reference);
+        sink += reference.max_run <= options.max_run && chi_square(&reference, options.length) <= options.max_chi2;
+    }
+    elapsed = seconds_now() - start;
+    fprintf(stderr, "sequence.c next():  %12.0f seeds/s\n", seeds / elapsed);
+
+    output = NULL;
+    start = seconds_now();
+    screen(1);
+    elapsed = seconds_now() - start;
+#ifdef LANES
+    fprintf(stderr, "%d-lane, 1 thread:   %12.0f seeds/s\n", LANES, seeds / elapsed);
+#else
+    fprintf(stderr, "scalar, 1 thread:   %12.0f seeds/s\n", seeds / elapsed);
+#endif
+
+    start = seconds_now();
+    screen(threads);
+    elapsed = seconds_now() - start;
+    fprintf(stderr, "%d threads:          %12.0f seeds/s\n", threads, seeds / elapsed);
+}
+
+int main(int argc, char **argv)
+{
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int do_verify = 0, do_benchmark = 0;
+    uint64_t count = options.end - options.first;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:n:l:r:x:t:vb")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            options.first = strtoull(optarg, NULL, 0);
+            break;
+        case 'n':
+            count = strtoull(optarg, NULL, 0);
+            break;
+        case 'l':
+            options.length = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            options.max_run = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'x':
+            options.max_chi2 = strtod(optarg, NULL);
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'v':
+            do_verify = 1;
+            break;
+        case 'b':
+            do_benchmark = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s first] [-n count] [-l length] [-r max_run] [-x max_chi2] [-t threads] [-v] [-b]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (options.first > UINT32_MAX || options.length == 0 || threads < 1)
+    {
+        fprintf(stderr, "seed must be 32 bits, length and threads at least 1\n");
+        return 2;
+    }
+    if (count > (1ULL << 32) - options.first)
+        count = (1ULL << 32) - options.first; // Clamp before adding so a huge -n cannot wrap
+    options.end = options.first + count;
+
+    if (do_verify)
+    {
+        uint64_t mismatches = verify();
+        fprintf(stderr, "verify: %" PRIu64 " of %" PRIu64 " seeds differ from sequence.c\n", mismatches, options.end - options.first);
+        return mismatches != 0;
+    }
+    if (do_benchmark)
+    {
+        benchmark(threads);
+        return 0;
+    }
+
+    output = stdout;
+    screen(threads);
+    fprintf(stderr, "accepted %" PRIu64 ", long runs %" PRIu64 ", skewed %" PRIu64 "\n", accepted, too_long, too_skewed);
+    return 0;
+}
@@ -0,0 +1,341 @@
+#include <setjmp.h>
+#include <signal.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "types.h"
+#include "sim.h"
+#include "vcd.h"
+
+// Interrupt vectors defined by the firmware, weak so builds that leave one out still link
+void TCB0_INT_vect(void) __attribute__((weak));
+void TCB1_INT_vect(void) __attribute__((weak));
+void SPI0_INT_vect(void) __attribute__((weak));
+
+// Firmware variables recorded alongside the pins
+extern volatile State STATE;
+extern volatile uint16_t time_passed;
+
+#define SPI_CYCLES_PER_BYTE 32 // 8 bits at the default SCK of CLK_PER / 4
+#define NEVER UINT64_MAX
+#define VCD_TICKS_PER_CYCLE 3  // One cycle is 300ns in the 100ns VCD timescale
+
+static Sim_Hooks hooks;
+static sigjmp_buf stop_point;
+static volatile sig_atomic_t hung;    // Set by the watchdog when simulated time stopped moving
+static uint64_t watchdog_cycle;       // Cycle count the watchdog saw last time
+static volatile sig_atomic_t host_busy; // Inside a hook or a VCD write, time standing still is not a hang
+
+static uint64_t cycle;                // Simulated CPU cycles since reset
+static uint64_t next_event = 0;       // Earliest cycle a timer, transfer or millisecond falls due
+static uint64_t next_ms;              // Cycle of the next millisecond callback
+static uint32_t ms_owed;              // Millisecond callbacks held back while in an interrupt
+static uint8_t interrupts_enabled;    // Global interrupt flag
+static uint8_t in_interrupt;          // Set while a vector runs, interrupts do not nest
+
+static uint8_t buttons;               // Buttons held down, as PORTA bits
+static uint64_t tcb_next[2] = {NEVER, NEVER}; // Next compare match of TCB0 and TCB1
+static uint8_t tcb_pending[2];        // Capture interrupt raised but not yet serviced
+static uint64_t spi_done = NEVER;     // Cycle the current SPI transfer completes
+static uint8_t spi_byte;              // Byte being shifted out
+static uint8_t spi_busy;              // Transfer in progress
+static uint8_t spi_pending;           // Transfer complete interrupt raised but not yet serviced
+static uint8_t shift_register;        // Display shift register contents
+static uint8_t display[2] = {0x7F, 0x7F}; // Latched segments, left and right digit
+static uint8_t buzzing;               // Buzzer PWM running with a real period
+static uint8_t recording;             // Waveform being written, see sim_vcd_open()
+
+// Applies the set/clear/toggle strobes the firmware has written to a port
+static void apply_port(PORT_t *port)
+{
+    if (port->DIRSET | port->DIRCLR | port->DIRTGL)
+    {
+        port->DIR = ((port->DIR | port->DIRSET) & ~port->DIRCLR) ^ port->DIRTGL;
+        port->DIRSET = port->DIRCLR = port->DIRTGL = 0;
+    }
+    if (port->OUTSET | port->OUTCLR | port->OUTTGL)
+    {
+        port->OUT = ((port->OUT | port->OUTSET) & ~port->OUTCLR) ^ port->OUTTGL;
+        port->OUTSET = port->OUTCLR = port->OUTTGL = 0;
+    }
+}
+
+// Commits the shift register to whichever digit its select bit addresses
+static void latch_display(void)
+{
+    uint8_t digit = (shift_register & 0x80) ? 0 : 1;
+    uint8_t segments = shift_register & 0x7F;
+
+    if (display[digit] != segments)
+    {
+        display[digit] = segments;
+        if (hooks.on_display)
+        {
+            host_busy++;
+            hooks.on_display(display[0], display[1]);
+            host_busy--;
+        }
+    }
+}
+
+// Brings the peripherals up to date with whatever the firmware wrote last
+static void apply_writes(void)
+{
+    uint8_t latch = io_PORTA.OUT & PIN1_bm;
+
+    apply_port(&io_PORTA);
+    apply_port(&io_PORTB);
+    apply_port(&io_PORTC);
+    if (!latch && (io_PORTA.OUT & PIN1_bm))
+        latch_display(); // Display latch (PA1) rising edge
+    io_PORTA.IN = (io_PORTA.OUT & io_PORTA.DIR) | (~buttons & ~io_PORTA.DIR);
+
+    if (io_SPI0.DATA != SPI_DATA_EMPTY)
+    {
+        if (io_SPI0.CTRLA & SPI_ENABLE_bm)
+        {
+            spi_byte = (uint8_t)io_SPI0.DATA;
+            spi_busy = 1;
+            spi_done = cycle + SPI_CYCLES_PER_BYTE;
+            if (spi_done < next_event)
+                next_event = spi_done;
+        }
+        io_SPI0.DATA = SPI_DATA_EMPTY;
+    }
+
+    uint8_t on = (io_TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm) && io_TCA0.SINGLE.PERBUF > 1;
+    if (on != buzzing)
+    {
+        buzzing = on;
+        if (hooks.on_buzzer)
+        {
+            host_busy++;
+            hooks.on_buzzer(on, io_TCA0.SINGLE.PERBUF);
+            host_busy--;
+        }
+    }
+
+    TCB_t *tcb[2] = {&io_TCB0, &io_TCB1};
+    for (int i = 0; i < 2; i++)
+    {
+        if (!(tcb[i]->CTRLA & TCB_ENABLE_bm))
+            tcb_next[i] = NEVER;
+        else if (tcb_next[i] == NEVER)
+        {
+            tcb_next[i] = cycle + tcb[i]->CCMP + 1;
+            if (tcb_next[i] < next_event)
+                next_event = tcb_next[i];
+        }
+    }
+}
+
+// Raises interrupt flags for everything that has fallen due
+static void advance_peripherals(void)
+{
+    TCB_t *tcb[2] = {&io_TCB0, &io_TCB1};
+
+    if (cycle >= spi_done)
+    {
+        shift_register = spi_byte;
+        spi_busy = 0;
+        spi_done = NEVER;
+        spi_pending = io_SPI0.INTCTRL & SPI_IE_bm;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (cycle >= tcb_next[i])
+        {
+            tcb_next[i] += tcb[i]->CCMP + 1;
+            tcb_pending[i] |= tcb[i]->INTCTRL & TCB_CAPT_bm;
+        }
+    }
+    while (cycle >= next_ms)
+    {
+        next_ms += SIM_CYCLES_PER_MS;
+        ms_owed++;
+    }
+
+    next_event = next_ms;
+    if (spi_done < next_event)
+        next_event = spi_done;
+    for (int i = 0; i < 2; i++)
+        if (tcb_next[i] < next_event)
+            next_event = tcb_next[i];
+}
+
+// Runs one interrupt vector, the firmware's own flag clearing is not modelled so it is done here
+static void run_vector(void (*vector)(void), uint8_t *pending)
+{
+    *pending = 0;
+    if (!vector)
+        return;
+    in_interrupt = 1;
+    vector();
+    in_interrupt = 0;
+}
+
+// Called before every register access the firmware makes
+static void sim_access(void)
+{
+    cycle += SIM_CYCLES_PER_ACCESS;
+    apply_writes();
+    if (cycle >= next_event)
+        advance_peripherals();
+    if (recording)
+    {
+        host_busy++;
+        vcd_sample(cycle * VCD_TICKS_PER_CYCLE);
+        host_busy--;
+    }
+    if (in_interrupt)
+        return;
+
+    // Service interrupts in vector table order
+    while (interrupts_enabled && (tcb_pending[0] | tcb_pending[1] | spi_pending))
+    {
+        if (tcb_pending[0])
+            run_vector(TCB0_INT_vect, &tcb_pending[0]);
+        else if (tcb_pending[1])
+            run_vector(TCB1_INT_vect, &tcb_pending[1]);
+        else
+            run_vector(SPI0_INT_vect, &spi_pending);
+    }
+
+    while (ms_owed)
+    {
+        ms_owed--;
+        if (hooks.on_ms)
+        {
+            host_busy++;
+            hooks.on_ms();
+            host_busy--;
+        }
+    }
+}
+
+void sim_sei(void)
+{
+    interrupts_enabled = 1;
+}
+
+void sim_cli(void)
+{
+    interrupts_enabled = 0;
+}
+
+void sim_delay_ms(double ms)
+{
+    uint64_t until = cycle + (uint64_t)(ms * SIM_CYCLES_PER_MS);
+    while (cycle < until)
+        io_access();
+}
+
+void sim_init(const Sim_Hooks *callbacks)
+{
+    hooks = *callbacks;
+    next_ms = SIM_CYCLES_PER_MS;
+}
+
+// Wall-clock check that the firmware still reaches io_access(); a loop that
+// only polls SRAM would otherwise stall simulated time and hang the run. Time
+// spent in the driving program's hooks or blocked writing the VCD is not held
+// against the firmware.
+static void watchdog(int signal)
+{
+    (void)signal;
+    if (!host_busy && cycle == watchdog_cycle)
+    {
+        hung = 1;
+        siglongjmp(stop_point, 1);
+    }
+    watchdog_cycle = cycle;
+}
+
+// Runs the firmware until a callback calls sim_stop(), returns -1 instead if
+// the firmware went SIM_HANG_SECONDS of wall-clock time without an io_access().
+// The caller's SIGALRM handler is put back on return.
+int sim_run(void)
+{
+    struct sigaction action = {.sa_handler = watchdog, .sa_flags = SA_RESTART};
+    struct sigaction saved;
+    struct itimerval interval = {{SIM_HANG_SECONDS, 0}, {SIM_HANG_SECONDS, 0}};
+    struct itimerval off = {{0, 0}, {0, 0}};
+
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, &saved);
+    watchdog_cycle = cycle - 1;
+    hung = 0;
+    host_busy = 0;
+    if (sigsetjmp(stop_point, 1) == 0)
+    {
+        setitimer(ITIMER_REAL, &interval, NULL);
+        io_access_hook = sim_access;
+        firmware_main();
+    }
+    setitimer(ITIMER_REAL, &off, NULL);
+    sigaction(SIGALRM, &saved, NULL);
+    io_access_hook = NULL;
+    in_interrupt = 0;
+    host_busy = 0;
+    return hung ? -1 : 0;
+}
+
+void sim_stop(void)
+{
+    siglongjmp(stop_point, 1);
+}
+
+// Streams the buzzer, latch, SPI, button and game state waveforms to a VCD file, returns 0 on success
+int sim_vcd_open(const char *path)
+{
+    static const Vcd_Signal signals[] = {
+        {"pb0_buzzer", &buzzing, 1, 0, 1},              // PWM running with a tone period, as the bot hears it
+        {"tca0_enable", &io_TCA0.SINGLE.CTRLA, 1, 0, 1}, // Raw enable bit, also set at boot with PER=1
+        {"tca0_period", &io_TCA0.SINGLE.PERBUF, 2, 0, 16},
+        {"pa1_latch", &io_PORTA.OUT, 1, 1, 1},
+        {"spi_data", &spi_byte, 1, 0, 8},
+        {"spi_busy", &spi_busy, 1, 0, 1},
+        {"display_left", &display[0], 1, 0, 7},
+        {"display_right", &display[1], 1, 0, 7},
+        {"pa4_s1", &io_PORTA.IN, 1, 4, 1},
+        {"pa5_s2", &io_PORTA.IN, 1, 5, 1},
+        {"pa6_s3", &io_PORTA.IN, 1, 6, 1},
+        {"pa7_s4", &io_PORTA.IN, 1, 7, 1},
+        {"state", &STATE, sizeof(STATE), 0, 3},
+        {"time_passed", &time_passed, 2, 0, 16},
+    };
+
+    if (vcd_open(path, "simon", "100ns", signals, sizeof(signals) / sizeof(signals[0])) != 0)
+        return -1;
+    recording = 1;
+    return 0;
+}
+
+// Stops recording, returns 0 if the whole waveform was written
+int sim_vcd_close(void)
+{
+    recording = 0;
+    return vcd_close();
+}
+
+uint64_t sim_cycles(void)
+{
+    return cycle;
+}
+
+double sim_ms(void)
+{
+    return (double)cycle / SIM_CYCLES_PER_MS;
+}
+
+void sim_set_buttons(uint8_t pressed)
+{
+    buttons = pressed;
+}
+
+void sim_set_pot(uint8_t value)
+{
+    io_ADC0.RESULT = value;
+}
@@ -0,0 +1,51 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+// Host simulator for the Simon Says firmware.
+//
+// The firmware sources are compiled for the host against the register stand-ins
+// in host/avr, with main() renamed to firmware_main(). Time advances by a fixed
+// number of CPU cycles per register access; between accesses the simulator
+// applies pending register writes, shifts SPI bytes into the display, and runs
+// the TCB0, TCB1 and SPI0 interrupts when they fall due.
+//
+// Because time only moves on register accesses, every firmware polling loop
+// must reach io_access() on each pass, by testing a flag in GPIOR0 (flags.h)
+// or reading a peripheral. A loop that only spins on SRAM variables freezes
+// simulated time; sim_run() detects that with a wall-clock watchdog and
+// returns -1 instead of hanging.
+//
+// The pins, SPI traffic, STATE and time_passed can be streamed to a VCD file
+// for GTKWave.
+
+#define SIM_F_CPU 3333333UL        // Main clock, 20MHz / 6
+#define SIM_CYCLES_PER_ACCESS 10   // Cycles charged for each register access
+#define SIM_CYCLES_PER_MS (SIM_F_CPU / 1000)
+#define SIM_HANG_SECONDS 2         // Wall-clock time without a register access that counts as a hang
+
+// Callbacks into the program driving the simulation, any may be NULL
+typedef struct
+{
+    void (*on_ms)(void);                               // Every simulated millisecond, outside interrupts
+    void (*on_buzzer)(uint8_t on, uint16_t period);    // Buzzer started (with its TCA0 period) or stopped
+    void (*on_display)(uint8_t left, uint8_t right);   // Latched segment pattern of either digit changed
+} Sim_Hooks;
+
+void sim_init(const Sim_Hooks *hooks);
+int sim_run(void);
+void sim_stop(void);
+
+uint64_t sim_cycles(void);
+double sim_ms(void);
+
+void sim_set_buttons(uint8_t pressed); // PIN4_bm..PIN7_bm of the buttons held down
+void sim_set_pot(uint8_t value);       // 8-bit potentiometer reading returned by the ADC
+
+int sim_vcd_open(const char *path);
+int sim_vcd_close(void);
+
+int firmware_main(void);
+
+#endif // SIM_H
@@ -0,0 +1,437 @@
+// Bot player and soak test for the Simon Says firmware, run in the host simulator.
+//
+// The bot listens to Simon's tones on the emulated buzzer, answers with button
+// presses on PA4-PA7 and reads victory or defeat off the latched display, the
+// same outputs a person at the board would use. It plays games back to back,
+// raising the level after each win, and loses on purpose at the maximum level
+// so every game ends. Tone lengths and spacing are checked against the firmware
+// timing, and anything the bot did not expect is counted as a desync:
+//   tone     a tone that does not match the pressed button, an extra Simon tone,
+//            or a buzzer period that is none of the four tones
+//   state    the firmware STATE or length_sequence disagrees with the bot
+//   missed   a press never produced a tone, or the tone never stopped
+//   result   the wrong outcome, or no outcome, was shown after the last press
+//   stall    nothing happened for 5 simulated seconds, or the firmware hung in a
+//            loop that never touches a register (see sim.h)
+// After a desync the bot waits for the next round of Simon's turn and picks up
+// the level from the firmware.
+//
+// Build from the repository root:
+//   gcc -O2 -Iinclude -Ihost -Dmain=firmware_main -c src/main.c -o firmware_main.o
+//   gcc -O2 -Iinclude -Ihost host/simon_bot.c host/sim.c host/vcd.c host/io.c src/buzzer.c src/display.c src/initialisation.c src/sequence.c src/timer.c src/uart.c firmware_main.o -lm -o simon_bot
+// Add -DDISPLAY_LATCH_DEFERRED to both commands to soak the deferred latch build.
+//
+// Usage:
+//   simon_bot [-g games] [-m max_level] [-e error_rate] [-H hold_ms] [-G gap_ms] [-p pot] [-s seed] [-d max_desyncs] [-w file.vcd] [-v]
+// The run stops early once max_desyncs (default 100) desyncs have been counted.
+// -w streams the simulated pins, SPI traffic, STATE and time_passed to a VCD
+// file that opens in GTKWave.
+// Exits with 1 if any desync was counted, 2 for bad arguments or a VCD file
+// that could not be opened or written in full.
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "types.h"
+#include "sim.h"
+
+#define PB_SHIFT 4              // Buttons S1-S4 are PA4-PA7
+#define TONE_MS 125             // Firmware plays each tone for 125ms
+#define TURN_MARGIN_MS 10       // Extra wait before answering after Simon's last tone
+#define RESULT_TIMEOUT_MS 100   // Longest wait for victory or defeat after the last tone
+#define STALL_MS 5000           // Longest time without a buzzer event
+#define SEGS_SUCCESS 0x00       // Display pattern for victory, see display.c
+#define SEGS_FAIL 0x77          // Display pattern for defeat
+#define MAX_LEVEL 1000
+#define UNKNOWN_TONE 0xFF       // tone_of() for a period that is none of the four tones
+
+// Firmware state the bot checks itself against
+extern volatile State STATE;
+extern volatile uint16_t length_sequence;
+
+typedef enum
+{
+    BOT_LISTEN,      // Recording Simon's tones
+    BOT_WAIT_TURN,   // Simon's silence after the last tone
+    BOT_PRESS,       // About to press the next button
+    BOT_HOLD,        // Holding a button down
+    BOT_WAIT_OFF,    // Released, waiting for the tone to stop
+    BOT_GAP,         // Pause before the next press
+    BOT_WAIT_RESULT, // Waiting for victory or defeat
+    BOT_RESYNC,      // Lost track, waiting for Simon's next turn
+} Bot_State;
+
+typedef enum
+{
+    DESYNC_TONE,
+    DESYNC_STATE,
+    DESYNC_MISSED,
+    DESYNC_RESULT,
+    DESYNC_STALL,
+    DESYNC_KINDS,
+} Desync_Kind;
+
+static const char *desync_names[DESYNC_KINDS] = {"tone", "state", "missed", "result", "stall"};
+
+// TCA0 periods set by buzzer_on() for each tone at the default octave
+static const uint16_t tone_periods[4] = {40040 >> 2, 47620 >> 2, 30028 >> 2, 80320 >> 2};
+
+// Command line settings
+static uint32_t target_games = 1000;
+static uint16_t max_level = 8;
+static double error_rate = 0;
+static uint32_t hold_ms = 40;
+static uint32_t gap_ms = 20;
+static uint8_t pot = 0; // 0 gives the minimum playback_duration of 250ms
+static uint32_t max_desyncs = 100;
+static const char *waveform;  // VCD file to record, if any
+static int verbose = 0;
+
+static Bot_State bot = BOT_LISTEN;
+static uint16_t level = 1;              // Sequence length the bot expects this round
+static uint16_t heard;                  // Tones heard so far this round
+static uint8_t sequence[MAX_LEVEL];     // Simon's tones this round
+static uint16_t press_index;            // Next tone to answer
+static uint8_t button;                  // Button being pressed
+static uint8_t press_heard;             // Tone heard for the current press
+static uint8_t went_wrong;              // Pressed a wrong button this round
+static double deadline;                 // When the current wait ends, in simulated ms
+static double last_event;               // Last buzzer event, for the stall watchdog
+static double tone_start, last_tone_start;
+
+// Results
+static uint32_t games, rounds, presses;
+static uint32_t desyncs[DESYNC_KINDS], total_desyncs;
+static double worst_tone_error, worst_spacing_error;
+
+static void desync(Desync_Kind kind, const char *what)
+{
+    desyncs[kind]++;
+    if (verbose)
+        printf("%10.1f ms  desync (%s): %s, level %u, STATE %d\n", sim_ms(), desync_names[kind], what, level, STATE);
+    sim_set_buttons(0);
+    bot = BOT_RESYNC;
+    if (++total_desyncs >= max_desyncs)
+        sim_stop();
+}
+
+static uint8_t tone_of(uint16_t period)
+{
+    for (uint8_t tone = 0; tone < 4; tone++)
+        if (tone_periods[tone] == period)
+            return tone;
+    return UNKNOWN_TONE;
+}
+
+// Playback duration the firmware derives from the potentiometer
+static double expected_playback_ms(void)
+{
+    return 2 * ((250 + ((1757UL * pot) >> 8)) >> 1);
+}
+
+static void start_round(void)
+{
+    heard = 0;
+    press_index = 0;
+    went_wrong = 0;
+    bot = BOT_LISTEN;
+}
+
+static void finish_round(uint8_t victory)
+{
+    rounds++;
+    if (victory != !went_wrong)
+        desync(DESYNC_RESULT, victory ? "victory after a wrong press" : "defeat after a correct sequence");
+    if (victory)
+        level++;
+    else
+    {
+        level = 1;
+        games++;
+        if (games >= target_games)
+            sim_stop();
+    }
+    if (bot != BOT_RESYNC)
+        start_round();
+}
+
+static void listen(uint8_t on, uint16_t period)
+{
+    double now = sim_ms();
+
+    if (!on)
+    {
+        double error = fabs(now - tone_start - TONE_MS);
+        if (error > worst_tone_error)
+            worst_tone_error = error;
+        if (heard == level)
+        {
+            deadline = last_tone_start + expected_playback_ms() + TURN_MARGIN_MS;
+            bot = BOT_WAIT_TURN;
+        }
+        return;
+    }
+
+    if (level >= MAX_LEVEL)
+    {
+        desync(DESYNC_STATE, "level is beyond what the bot can record");
+        return;
+    }
+    if (heard == 0 && length_sequence != level)
+    {
+        desync(DESYNC_STATE, "length_sequence differs from the bot's level");
+        return;
+    }
+    if (heard >= level)
+    {
+        desync(DESYNC_TONE, "Simon played more tones than the level");
+        return;
+    }
+    uint8_t tone = tone_of(period);
+    if (tone == UNKNOWN_TONE)
+    {
+        desync(DESYNC_TONE, "unknown tone period");
+        return;
+    }
+    if (heard > 0)
+    {
+        double error = fabs(now - last_tone_start - expected_playback_ms());
+        if (error > worst_spacing_error)
+            worst_spacing_error = error;
+    }
+    sequence[heard++] = tone;
+    tone_start = last_tone_start = now;
+}
+
+static void on_buzzer(uint8_t on, uint16_t period)
+{
+    last_event = sim_ms();
+
+    switch (bot)
+    {
+    case BOT_LISTEN:
+        listen(on, period);
+        break;
+
+    case BOT_HOLD:
+    case BOT_WAIT_OFF:
+        if (on)
+        {
+            uint8_t tone = tone_of(period);
+            if (tone == UNKNOWN_TONE)
+                desync(DESYNC_TONE, "unknown tone period");
+            else if (tone != button)
+                desync(DESYNC_TONE, "tone does not match the pressed button");
+            press_heard = 1;
+        }
+        else if (bot == BOT_WAIT_OFF)
+        {
+            press_index++;
+            if (press_index == level || went_wrong)
+            {
+                deadline = sim_ms() + RESULT_TIMEOUT_MS;
+                bot = BOT_WAIT_RESULT;
+            }
+            else
+            {
+                deadline = sim_ms() + gap_ms;
+                bot = BOT_GAP;
+            }
+        }
+        break;
+
+    case BOT_RESYNC:
+        // Simon's first tone of a round, start listening from here
+        if (on && STATE == SIMONS_TURN)
+        {
+            level = length_sequence;
+            start_round();
+            listen(on, period);
+        }
+        break;
+
+    default:
+        if (on)
+            desync(DESYNC_TONE, "unexpected tone");
+        break;
+    }
+}
+
+static void on_display(uint8_t left, uint8_t right)
+{
+    if (bot != BOT_WAIT_RESULT || left != right)
+        return;
+    if (left == SEGS_SUCCESS)
+        finish_round(1);
+    else if (left == SEGS_FAIL)
+        finish_round(0);
+}
+
+static void on_ms(void)
+{
+    double now = sim_ms();
+
+    if (now - last_event > STALL_MS)
+    {
+        last_event = now;
+        desync(DESYNC_STALL, "no tone for 5s");
+    }
+
+    switch (bot)
+    {
+    case BOT_WAIT_TURN:
+        if (now >= deadline)
+        {
+            if (STATE != PLAYERS_TURN)
+                desync(DESYNC_STATE, "not the player's turn after Simon's silence");
+            else
+                bot = BOT_PRESS;
+        }
+        break;
+
+    case BOT_PRESS:
+        button = sequence[press_index];
+        if ((level >= max_level && press_index == level - 1) || rand() < error_rate * ((double)RAND_MAX + 1))
+        {
+            button = (button + 1 + rand() % 3) % 4; // Any of the other three buttons
+            went_wrong = 1;
+        }
+        sim_set_buttons(1 << (button + PB_SHIFT));
+        presses++;
+        press_heard = 0;
+        deadline = now + hold_ms;
+        bot = BOT_HOLD;
+        break;
+
+    case BOT_HOLD:
+        if (now >= deadline)
+        {
+            sim_set_buttons(0);
+            deadline = now + TONE_MS + 50;
+            bot = BOT_WAIT_OFF;
+        }
+        break;
+
+    case BOT_WAIT_OFF:
+        if (now >= deadline)
+            desync(DESYNC_MISSED, press_heard ? "tone did not stop after release" : "press produced no tone");
+        break;
+
+    case BOT_GAP:
+        if (now >= deadline)
+            bot = BOT_PRESS;
+        break;
+
+    case BOT_WAIT_RESULT:
+        if (now >= deadline)
+            desync(DESYNC_RESULT, "no victory or defeat shown");
+        break;
+
+    case BOT_RESYNC:
+        // Tap a button now and then if the firmware is stuck waiting for input
+        if (STATE == PLAYERS_TURN && now >= deadline)
+        {
+            sim_set_buttons(((uint32_t)now / 100) % 2 ? 1 << PB_SHIFT : 0);
+            deadline = now + 50;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:m:e:H:G:p:s:d:w:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'g':
+            target_games = strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            max_level = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'e':
+            error_rate = strtod(optarg, NULL);
+            break;
+        case 'H':
+            hold_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'G':
+            gap_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            pot = (uint8_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            max_desyncs = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            waveform = optarg;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-g games] [-m max_level] [-e error_rate] [-H hold_ms] [-G gap_ms] [-p pot] [-s seed] [-d max_desyncs] [-w file.vcd] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (target_games == 0 || max_level == 0 || max_level >= MAX_LEVEL)
+    {
+        fprintf(stderr, "games must be at least 1 and max_level between 1 and %d\n", MAX_LEVEL - 1);
+        return 2;
+    }
+
+    Sim_Hooks hooks = {on_ms, on_buzzer, on_display};
+    struct timespec start, end;
+
+    srand(seed);
+    sim_init(&hooks);
+    sim_set_pot(pot);
+    if (waveform && sim_vcd_open(waveform) != 0)
+    {
+        perror(waveform);
+        return 2;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int hang = sim_run();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    int vcd_failed = sim_vcd_close() != 0;
+    int vcd_errno = errno;
+
+    double wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    if (hang)
+    {
+        // Counted directly, the simulation has already stopped so desync() cannot resync
+        desyncs[DESYNC_STALL]++;
+        total_desyncs++;
+        printf("firmware hung at %.1f ms: no register access for %ds, STATE %d\n", sim_ms(), SIM_HANG_SECONDS, STATE);
+    }
+    printf("games %u, rounds %u, presses %u\n", games, rounds, presses);
+    printf("simulated %.1f s in %.2f s wall, %.1f games/s, %.0fx real time\n", sim_ms() / 1000, wall, games / wall, sim_ms() / 1000 / wall);
+    printf("worst tone length error %.2f ms, worst tone spacing error %.2f ms\n", worst_tone_error, worst_spacing_error);
+    printf("desyncs:");
+    for (int kind = 0; kind < DESYNC_KINDS; kind++)
+        printf(" %s %u", desync_names[kind], desyncs[kind]);
+    printf("\n");
+    if (vcd_failed)
+    {
+        errno = vcd_errno;
+        perror(waveform);
+        return 2;
+    }
+    return total_desyncs != 0;
+}
@@ -0,0 +1,10 @@
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+
+// Host stand-in for <util/delay.h>, busy waits advance simulated time
+
+void sim_delay_ms(double ms);
+
+#define _delay_ms(ms) sim_delay_ms(ms)
+
+#endif // HOST_UTIL_DELAY_H
@@ -0,0 +1,111 @@
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include "vcd.h"
+
+static FILE *file;
+static Vcd_Signal signals[VCD_MAX_SIGNALS];
+static uint32_t last[VCD_MAX_SIGNALS]; // Value last written for each signal
+static int signal_count;
+static uint64_t last_time;
+
+static uint32_t read_signal(const Vcd_Signal *signal)
+{
+    uint32_t value;
+
+    switch (signal->size)
+    {
+    case 1:
+        value = *(const volatile uint8_t *)signal->value;
+        break;
+    case 2:
+        value = *(const volatile uint16_t *)signal->value;
+        break;
+    default:
+        value = *(const volatile uint32_t *)signal->value;
+        break;
+    }
+    value >>= signal->shift;
+    return (signal->width < 32) ? value & ((1UL << signal->width) - 1) : value;
+}
+
+// Writes one value change, identifiers are single printable characters from '!'
+static void write_value(int index, uint32_t value)
+{
+    if (signals[index].width == 1)
+    {
+        fprintf(file, "%u%c\n", (unsigned)value, '!' + index);
+        return;
+    }
+    fputc('b', file);
+    for (int bit = signals[index].width - 1; bit >= 0; bit--)
+        fputc((value >> bit) & 1 ? '1' : '0', file);
+    fprintf(file, " %c\n", '!' + index);
+}
+
+// Starts a recording at time 0, returns 0 on success or -1 with errno set
+int vcd_open(const char *path, const char *scope, const char *timescale, const Vcd_Signal *list, int count)
+{
+    time_t now = time(NULL);
+
+    if (count > VCD_MAX_SIGNALS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(file = fopen(path, "w")))
+        return -1;
+    signal_count = count;
+    last_time = 0;
+
+    fprintf(file, "$date %s$end\n", ctime(&now));
+    fprintf(file, "$version Simon Says host simulator $end\n");
+    fprintf(file, "$timescale %s $end\n", timescale);
+    fprintf(file, "$scope module %s $end\n", scope);
+    for (int i = 0; i < count; i++)
+    {
+        signals[i] = list[i];
+        fprintf(file, "$var wire %u %c %s $end\n", signals[i].width, '!' + i, signals[i].name);
+    }
+    fprintf(file, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (int i = 0; i < count; i++)
+    {
+        last[i] = read_signal(&signals[i]);
+        write_value(i, last[i]);
+    }
+    fprintf(file, "$end\n");
+    return 0;
+}
+
+// Records every signal that changed since the last sample
+void vcd_sample(uint64_t time)
+{
+    if (!file)
+        return;
+    for (int i = 0; i < signal_count; i++)
+    {
+        uint32_t value = read_signal(&signals[i]);
+        if (value == last[i])
+            continue;
+        if (time != last_time)
+        {
+            fprintf(file, "#%llu\n", (unsigned long long)time);
+            last_time = time;
+        }
+        last[i] = value;
+        write_value(i, value);
+    }
+}
+
+// Ends the recording, returns 0 if everything reached the file or -1 with errno set
+int vcd_close(void)
+{
+    if (!file)
+        return 0;
+    fprintf(file, "#%llu\n", (unsigned long long)last_time + 1);
+    int failed = ferror(file);
+    if (fclose(file) != 0)
+        failed = 1;
+    file = NULL;
+    return failed ? -1 : 0;
+}
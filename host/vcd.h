@@ -0,0 +1,25 @@
+#ifndef VCD_H
+#define VCD_H
+
+#include <stdint.h>
+
+// Streaming Value Change Dump writer. Each signal is a bit field read straight
+// from memory on every sample; a sample writes only the signals that changed,
+// so nothing is buffered beyond stdio and recordings can run for any length.
+
+#define VCD_MAX_SIGNALS 32
+
+typedef struct
+{
+    const char *name;            // Wire name shown in the viewer
+    const volatile void *value;  // Variable or register holding the signal
+    uint8_t size;                // Size of *value in bytes: 1, 2 or 4
+    uint8_t shift;               // Lowest bit of the signal within *value
+    uint8_t width;               // Number of bits
+} Vcd_Signal;
+
+int vcd_open(const char *path, const char *scope, const char *timescale, const Vcd_Signal *signals, int count);
+void vcd_sample(uint64_t time);
+int vcd_close(void);
+
+#endif // VCD_H
@@ -23,6 +23,11 @@
 #define TONE_3 2
 #define TONE_4 3
 
+// Build with -DDISPLAY_LATCH_DEFERRED to latch the display from the 5ms
+// display tick (TCB1) instead of from the SPI transfer-complete interrupt.
+// Each tick commits the byte shifted out on the previous tick, then sends
+// the next one, so SPI0_INT_vect is not needed at all.
+
 void clear_display(void);
 void spi_init(void);
 void spi_write(uint8_t b);
@@ -36,4 +41,12 @@ extern volatile uint8_t segs[2];
 
 void is_sequence_confirmed(uint8_t tone_digit, uint8_t lfsr_digit);
 
+// Pulse the display latch to commit the last byte shifted out over SPI.
+// Inline so the ISRs that call it don't pay for a function call.
+static inline void display_latch(void)
+{
+    PORTA.OUTCLR = PIN1_bm; // Clear the latch pin
+    PORTA.OUTSET = PIN1_bm; // Set the latch pin high to commit data
+}
+
 #endif // DISPLAY_H
@@ -0,0 +1,28 @@
+#ifndef FLAGS_H
+#define FLAGS_H
+
+#include <stdint.h>
+#include <avr/io.h>
+
+// Game flags packed into the GPIOR0 general purpose I/O register. GPIOR0 sits
+// in the low I/O space, so testing or changing a single flag compiles to one
+// SBIS/SBIC/SBI/CBI instead of loading a variable from SRAM.
+typedef struct
+{
+    uint8_t reset : 1;                   // Game reset flag
+    uint8_t new_seed : 1;                // Flag for new seed generation
+    uint8_t updating_playback_delay : 1; // Flag to update playback duration
+    uint8_t pb_released : 1;             // Flag for button release state
+    uint8_t sequence_confirmed : 1;      // Flag for sequence confirmation
+} Flags;
+
+#define FLAGS (*(volatile Flags *)&GPIOR0)
+
+// Keep the original flag names so they are read and written as before
+#define reset FLAGS.reset
+#define new_seed FLAGS.new_seed
+#define updating_playback_delay FLAGS.updating_playback_delay
+#define pb_released FLAGS.pb_released
+#define sequence_confirmed FLAGS.sequence_confirmed
+
+#endif // FLAGS_H
@@ -2,6 +2,9 @@
 #define SEQUENCE_H
 
 #include <stdint.h>
+#include "flags.h"
+
+#define LFSR_MASK 0xE2023CAB // Galois LFSR tap mask
 
 void next(void);
 void reset_lfsr_state(void);
@@ -11,7 +14,5 @@ extern volatile uint32_t new_state_lfsr;
 extern volatile uint32_t start_state_lfsr;
 extern volatile uint32_t state_lfsr;
 extern volatile uint8_t next_lfsr_digit;
-extern volatile uint8_t new_seed;
-extern volatile uint32_t sequence_confirmed;
 
 #endif // SEQUENCE_H
@@ -2,11 +2,11 @@
 #define TIMER_H
 
 #include <stdint.h>
+#include "flags.h"
 
 void pb_debounce(void);
 
 extern volatile uint8_t pb_debounced_state;
-extern volatile uint8_t updating_playback_delay;
 extern volatile uint16_t time_passed;
 extern volatile uint16_t new_playback_duration;
 extern volatile uint16_t playback_duration;
@@ -2,7 +2,6 @@
 #define UART_H
 
 #include <stdint.h>
-
-extern volatile uint8_t reset;
+#include "flags.h"
 
 #endif // UART_H
@@ -81,12 +81,13 @@ void display_score(uint32_t count)
     }
 }
 
+#ifndef DISPLAY_LATCH_DEFERRED
 // SPI interrupt service routine to handle display updates
 ISR(SPI0_INT_vect)
 {
     // Toggle the display latch to update the physical display
-    PORTA.OUTCLR = PIN1_bm; // Clear the latch pin
-    PORTA.OUTSET = PIN1_bm; // Set the latch pin high to commit data
+    display_latch();
 
     SPI0.INTFLAGS = SPI_IF_bm; // Clear the interrupt flag to prepare for next SPI transmission
 }
+#endif
@@ -42,7 +42,9 @@ void spi_init(void)
     // Configure SPI settings for Master mode and enable SPI
     PORTMUX.SPIROUTEA = PORTMUX_SPI0_ALT1_gc;   // Use alternate pin configuration for SPI
     SPI0.CTRLB = SPI_SSD_bm;                    // Disable Slave Select
+#ifndef DISPLAY_LATCH_DEFERRED
     SPI0.INTCTRL = SPI_IE_bm;                   // Enable SPI interrupts
+#endif
     SPI0.CTRLA = SPI_MASTER_bm | SPI_ENABLE_bm; // Set as master and enable SPI
 }
 
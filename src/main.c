@@ -15,18 +15,9 @@ volatile uint16_t length_sequence = 1;                    // Length of the Simon
 volatile Players_Turn_State PLAYERS_STATE = PLAYER_PAUSE; // Player's turn state.
 volatile Simons_Turn_State SIMONS_STATE = SIMON_SILENT;   // Simon's turn state.
 volatile int32_t index_tone = 0;                          // Current tone index in the sequence.
-volatile uint32_t sequence_confirmed = 1;                 // Flag for sequence confirmation.
 volatile uint8_t player_input_tracker = 0;                // Tracks player inputs.
-volatile uint8_t pb_released = 0;                         // Flag for button release state.
 volatile Level_State LEVEL_STATE;                         // State of game level.
 uint32_t players_rank = 0;                                // Player's current rank.
-volatile uint8_t pb_state;                                // State of the push buttons.
-volatile uint8_t new_seed;                                // Flag for new seed generation.
-volatile uint8_t reset;                                   // Game reset flag.
-volatile uint8_t next_lfsr_digit;                         // Next digit in LFSR sequence.
-volatile uint8_t updating_playback_delay;                 // Flag for updating playback delay.
-volatile uint16_t time_passed;                            // Time passed for timing events.
-volatile uint16_t playback_duration;                      // Duration for playback events.
 
 // Function declarations for game logic components.
 void reset_lfsr_state();
@@ -314,6 +305,9 @@ static void state_machine(void)
 int main(void)
 {
     cli();         // Disable global interrupts for setup.
+    // Flags live in GPIOR0, which resets to zero, so set the ones that start high.
+    updating_playback_delay = 1;
+    sequence_confirmed = 1;
     button_init(); // Initialize button hardware.
     spi_init();    // Initialize SPI interface.
     adc_init();    // Initialize analog-to-digital converter.
@@ -9,7 +9,6 @@ volatile uint8_t pb_debounced_state = 0xFF;    // Current debounced state of pus
 volatile uint16_t time_passed = 0;        // Tracks the elapsed time
 volatile uint16_t playback_duration = 250;     // Default playback duration
 volatile uint16_t new_playback_duration = 250; // New duration calculated from ADC input
-volatile uint8_t updating_playback_delay = 1;  // Flag to update playback duration
 volatile uint8_t pb_state = 0xFF;              // Current state of pushbuttons
 
 // Debounces pushbutton inputs
@@ -27,6 +26,9 @@ ISR(TCB1_INT_vect)
 {
     pb_debounce();
     static uint8_t digit = 0;
+#ifdef DISPLAY_LATCH_DEFERRED
+    display_latch(); // Commit the byte sent on the previous tick, its transfer is long complete
+#endif
     digit = !digit;                                     // Toggle digit for display update
     spi_write(digit ? segs[0] | (0x01 << 7) : segs[1]); // Update display via SPI
     TCB1.INTFLAGS = TCB_CAPT_bm;                        // Clear the interrupt flag
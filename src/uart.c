@@ -5,5 +5,4 @@
 #include "buzzer.h"
 #include "sequence.h"
 #include "types.h"
-
-volatile uint8_t reset = 0;
\ No newline at end of file
+#include "uart.h"
\ No newline at end of file